@@ -0,0 +1,582 @@
+#include "interfaces/IMappedVector.h"
+#include "interfaces/ILogger.h"
+#include <cmath>
+#include <new>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+IMappedVector::~IMappedVector() = default;
+
+namespace {
+
+    // coordinates processed per streaming step (512 KiB)
+    const size_t CHUNK_SIZE = 1u << 16u;
+
+    class MappedVector_Impl : public IMappedVector {
+    public:
+        MappedVector_Impl(size_t dim, double *pCoords, int fd, bool readOnly, ILogger* pLogger);
+        ~MappedVector_Impl() override;
+        IVector* clone() const override;
+        size_t getDim() const override;
+        double getCoord(size_t index) const override;
+        RESULT_CODE setCoord(size_t index, double value) override;
+        double norm(NORM norm) const override;
+        RESULT_CODE flush() override;
+        double* data() const;
+
+        // takes ownership of fd, -1 means anonymous pages
+        static MappedVector_Impl* map(size_t dim, int fd, bool readOnly, ILogger* pLogger);
+        static MappedVector_Impl* create(size_t dim, char const* pFile, ILogger* pLogger);
+        static MappedVector_Impl* openFile(size_t dim, char const* pFile, bool readOnly, ILogger* pLogger);
+        static std::atomic<size_t> threadCount;
+    protected:
+        size_t m_dim{0};
+        double *m_ptr_coord{nullptr};
+        int m_fd{-1};
+        bool m_readOnly{false};
+        ILogger * logger {nullptr};
+    };
+    std::atomic<size_t> MappedVector_Impl::threadCount{1};
+
+    bool isMapped(IVector const* pVector){
+        return dynamic_cast<MappedVector_Impl const*>(pVector) != nullptr;
+    }
+
+    // Coordinates [begin, begin + len) of pVector: a pointer into the mapping for mapped
+    // vectors, otherwise pBuf filled through getCoord(...)
+    const double* chunkOf(IVector const* pVector, size_t begin, size_t len, double* pBuf){
+        auto *pMapped = dynamic_cast<MappedVector_Impl const*>(pVector);
+        if (pMapped != nullptr){
+            return pMapped->data() + begin;
+        }
+        for (size_t i = 0; i < len; ++i){
+            pBuf[i] = pVector->getCoord(begin + i);
+        }
+        return pBuf;
+    }
+
+    // asks the kernel to start reading the chunk in while the current one is processed
+    void prefetch(IVector const* pVector, size_t begin, size_t len){
+        auto *pMapped = dynamic_cast<MappedVector_Impl const*>(pVector);
+        if (pMapped == nullptr){
+            return;
+        }
+        static const auto pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+        auto addr = reinterpret_cast<uintptr_t>(pMapped->data() + begin);
+        uintptr_t aligned = addr & ~(pageSize - 1);
+        madvise(reinterpret_cast<void *>(aligned), addr - aligned + len * sizeof(double), MADV_WILLNEED);
+    }
+
+    // read once per pass, setThreadCount(...) may run concurrently
+    size_t threadsFor(size_t dim){
+        size_t chunks = (dim + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        return std::max<size_t>(1, std::min(MappedVector_Impl::threadCount.load(), chunks));
+    }
+
+    // Splits [0, dim) into `threads` contiguous ranges and walks each of them chunk by chunk,
+    // calling f(thread, pChunk1, pChunk2, begin, len); pChunk2 is nullptr when pOperand2 is nullptr.
+    // f must not throw, a thread that fails to start runs its range on the calling thread
+    template <class F>
+    RESULT_CODE streamChunks(size_t dim, size_t threads, IVector const* pOperand1, IVector const* pOperand2,
+                             ILogger* pLogger, F const& f){
+        bool needBuf1 = !isMapped(pOperand1);
+        bool needBuf2 = pOperand2 != nullptr && !isMapped(pOperand2);
+        size_t buffers = (needBuf1 ? 1 : 0) + (needBuf2 ? 1 : 0);
+        double *pBuf = nullptr;
+        if (buffers){
+            pBuf = new(std::nothrow) double[threads * buffers * CHUNK_SIZE];
+            if (!pBuf){
+                if (pLogger != nullptr){
+                    pLogger->log("In streaming pass", RESULT_CODE::OUT_OF_MEMORY);
+                }
+                return RESULT_CODE::OUT_OF_MEMORY;
+            }
+        }
+        auto worker = [&](size_t thread, size_t from, size_t to){
+            double *pBuf1 = needBuf1 ? pBuf + thread * buffers * CHUNK_SIZE : nullptr;
+            double *pBuf2 = needBuf2 ? pBuf + (thread * buffers + buffers - 1) * CHUNK_SIZE : nullptr;
+            for (size_t begin = from; begin < to; begin += CHUNK_SIZE){
+                size_t len = std::min(CHUNK_SIZE, to - begin);
+                size_t next = begin + len;
+                if (next < to){
+                    size_t nextLen = std::min(CHUNK_SIZE, to - next);
+                    prefetch(pOperand1, next, nextLen);
+                    if (pOperand2 != nullptr){
+                        prefetch(pOperand2, next, nextLen);
+                    }
+                }
+                const double *pChunk1 = chunkOf(pOperand1, begin, len, pBuf1);
+                const double *pChunk2 = pOperand2 != nullptr ? chunkOf(pOperand2, begin, len, pBuf2) : nullptr;
+                f(thread, pChunk1, pChunk2, begin, len);
+            }
+        };
+        size_t step = (dim + threads - 1) / threads;
+        std::vector<std::thread> pool;
+        try {
+            pool.reserve(threads - 1);
+        } catch (...){
+            // emplace_back below falls back to the calling thread
+        }
+        for (size_t t = 1; t < threads; ++t){
+            size_t from = t * step;
+            size_t to = std::min(dim, from + step);
+            if (from >= to){
+                break;
+            }
+            try {
+                pool.emplace_back(worker, t, from, to);
+            } catch (...){
+                worker(t, from, to);
+            }
+        }
+        worker(0, 0, std::min(dim, step));
+        for (auto &thread : pool){
+            thread.join();
+        }
+        delete[] pBuf;
+        return RESULT_CODE::SUCCESS;
+    }
+
+    RESULT_CODE checkNan(IVector const* pVector, ILogger* pLogger){
+        size_t threads = threadsFor(pVector->getDim());
+        std::vector<char> found(threads, 0);
+        RESULT_CODE rc = streamChunks(pVector->getDim(), threads, pVector, nullptr, pLogger,
+                                      [&](size_t t, const double *a, const double *, size_t, size_t len){
+            for (size_t i = 0; i < len && !found[t]; ++i){
+                found[t] = __isnan(a[i]) ? 1 : 0;
+            }
+        });
+        if (rc != RESULT_CODE::SUCCESS){
+            return rc;
+        }
+        if (std::find(found.begin(), found.end(), 1) != found.end()){
+            if (pLogger != nullptr){
+                pLogger->log("In mapped file", RESULT_CODE::NAN_VALUE);
+            }
+            return RESULT_CODE::NAN_VALUE;
+        }
+        return RESULT_CODE::SUCCESS;
+    }
+
+    // norm of pOperand1 - pOperand2, or of pOperand1 alone if pOperand2 is nullptr
+    double streamNorm(IVector const* pOperand1, IVector const* pOperand2, IVector::NORM norm, ILogger* pLogger){
+        if (norm != IVector::NORM::NORM_1 && norm != IVector::NORM::NORM_2 && norm != IVector::NORM::NORM_INF){
+            if (pLogger != nullptr){
+                pLogger->log("In norm(...) unknown type of norm", RESULT_CODE::WRONG_ARGUMENT);
+            }
+            return NAN;
+        }
+        size_t threads = threadsFor(pOperand1->getDim());
+        std::vector<double> partial(threads, 0);
+        RESULT_CODE rc = streamChunks(pOperand1->getDim(), threads, pOperand1, pOperand2, pLogger,
+                                      [&](size_t t, const double *a, const double *b, size_t, size_t len){
+            double ans = partial[t];
+            for (size_t i = 0; i < len; ++i){
+                double val = fabs(b != nullptr ? a[i] - b[i] : a[i]);
+                switch (norm){
+                    case IVector::NORM::NORM_1:
+                        ans += val;
+                        break;
+                    case IVector::NORM::NORM_2:
+                        ans += val * val;
+                        break;
+                    default:
+                        ans = val > ans ? val : ans;
+                        break;
+                }
+            }
+            partial[t] = ans;
+        });
+        if (rc != RESULT_CODE::SUCCESS){
+            return NAN;
+        }
+        double ans = 0;
+        for (double val : partial){
+            ans = norm == IVector::NORM::NORM_INF ? (val > ans ? val : ans) : ans + val;
+        }
+        if (norm == IVector::NORM::NORM_2){
+            ans = sqrt(ans);
+        }
+        if (__isnan(ans)){
+            if (pLogger != nullptr){
+                pLogger->log("In norm(...)", RESULT_CODE::CALCULATION_ERROR);
+            }
+            return NAN;
+        }
+        return ans;
+    }
+
+    // result[i] = op(a[i], b[i]) streamed into a new mapped vector, b is nullptr for unary op
+    template <class Op>
+    IMappedVector* streamMap(IVector const* pOperand1, IVector const* pOperand2, char const* pFile, ILogger* pLogger,
+                             char const* pWhere, Op const& op){
+        size_t _dim = pOperand1->getDim();
+        MappedVector_Impl *pResult = MappedVector_Impl::create(_dim, pFile, pLogger);
+        if (pResult == nullptr){
+            return nullptr;
+        }
+        double *pOut = pResult->data();
+        size_t threads = threadsFor(_dim);
+        std::vector<char> found(threads, 0);
+        RESULT_CODE rc = streamChunks(_dim, threads, pOperand1, pOperand2, pLogger,
+                                      [&](size_t t, const double *a, const double *b, size_t begin, size_t len){
+            for (size_t i = 0; i < len; ++i){
+                double val = op(a[i], b != nullptr ? b[i] : 0);
+                found[t] |= __isnan(val) ? 1 : 0;
+                pOut[begin + i] = val;
+            }
+        });
+        if (rc != RESULT_CODE::SUCCESS){
+            delete pResult;
+            return nullptr;
+        }
+        if (std::find(found.begin(), found.end(), 1) != found.end()){
+            if (pLogger != nullptr){
+                pLogger->log(pWhere, RESULT_CODE::CALCULATION_ERROR);
+            }
+            delete pResult;
+            return nullptr;
+        }
+        return pResult;
+    }
+
+    bool checkDim(size_t dim, ILogger* pLogger){
+        if (!dim || dim > PTRDIFF_MAX / sizeof(double)){
+            if (pLogger != nullptr){
+                pLogger->log("In createMappedVector(...) dimension must be more than 0 and fit the address space",
+                             RESULT_CODE::WRONG_DIM);
+            }
+            return false;
+        }
+        return true;
+    }
+
+    bool checkOperands(IVector const* pOperand1, IVector const* pOperand2, ILogger* pLogger, char const* pWhere){
+        if (pOperand1 == nullptr || pOperand2 == nullptr){
+            if (pLogger != nullptr){
+                pLogger->log(pWhere, RESULT_CODE::BAD_REFERENCE);
+            }
+            return false;
+        }
+        if (pOperand1->getDim() != pOperand2->getDim()){
+            if (pLogger != nullptr){
+                pLogger->log(pWhere, RESULT_CODE::WRONG_DIM);
+            }
+            return false;
+        }
+        return true;
+    }
+}//end MappedVector_Impl
+
+MappedVector_Impl::MappedVector_Impl(size_t dim, double *pCoords, int fd, bool readOnly, ILogger* pLogger):
+        m_dim(dim), m_ptr_coord(pCoords), m_fd(fd), m_readOnly(readOnly), logger(pLogger){}
+
+MappedVector_Impl::~MappedVector_Impl(){
+    munmap(m_ptr_coord, m_dim * sizeof(double));
+    if (m_fd != -1){
+        close(m_fd);
+    }
+}
+
+MappedVector_Impl* MappedVector_Impl::map(size_t dim, int fd, bool readOnly, ILogger* pLogger) {
+    size_t _size = dim * sizeof(double);
+    // anonymous pages are accounted against overcommit here, so lack of memory fails mmap
+    // instead of faulting later; read-only files are mapped privately so nothing reaches the disk
+    int flags = fd == -1 ? MAP_PRIVATE | MAP_ANONYMOUS : (readOnly ? MAP_PRIVATE : MAP_SHARED);
+    int prot = readOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+    void *ptr = mmap(nullptr, _size, prot, flags, fd, 0);
+    if (ptr == MAP_FAILED){
+        if (fd != -1){
+            close(fd);
+        }
+        if (pLogger != nullptr){
+            pLogger->log("In createMappedVector(...) mmap failed", RESULT_CODE::OUT_OF_MEMORY);
+        }
+        return nullptr;
+    }
+    madvise(ptr, _size, MADV_SEQUENTIAL);
+    auto *pVector = new(std::nothrow) MappedVector_Impl(dim, reinterpret_cast<double *>(ptr), fd, readOnly,
+                                                                  pLogger);
+    if (!pVector){
+        munmap(ptr, _size);
+        if (fd != -1){
+            close(fd);
+        }
+        if (pLogger != nullptr){
+            pLogger->log("In createMappedVector(...)", RESULT_CODE::OUT_OF_MEMORY);
+        }
+    }
+    return pVector;
+}
+
+MappedVector_Impl* MappedVector_Impl::create(size_t dim, char const* pFile, ILogger* pLogger) {
+    if (!checkDim(dim, pLogger)){
+        return nullptr;
+    }
+    if (pFile == nullptr){
+        return map(dim, -1, false, pLogger);
+    }
+    int fd = ::open(pFile, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1){
+        if (pLogger != nullptr){
+            pLogger->log("In createMappedVector(...) can't create file", RESULT_CODE::FILE_ERROR);
+        }
+        return nullptr;
+    }
+    // blocks are reserved up front, a sparse file would fail with SIGBUS on a full disk instead
+    auto _size = static_cast<off_t>(dim * sizeof(double));
+    int err = posix_fallocate(fd, 0, _size);
+    if (err == EINVAL || err == EOPNOTSUPP){
+        err = ftruncate(fd, _size) == -1 ? errno : 0;
+    }
+    if (err != 0){
+        ftruncate(fd, 0);
+        close(fd);
+        if (pLogger != nullptr){
+            pLogger->log("In createMappedVector(...) can't reserve space for file", RESULT_CODE::FILE_ERROR);
+        }
+        return nullptr;
+    }
+    return map(dim, fd, false, pLogger);
+}
+
+MappedVector_Impl* MappedVector_Impl::openFile(size_t dim, char const* pFile, bool readOnly, ILogger* pLogger) {
+    if (!checkDim(dim, pLogger)){
+        return nullptr;
+    }
+    int fd = ::open(pFile, readOnly ? O_RDONLY : O_RDWR);
+    if (fd == -1){
+        if (pLogger != nullptr){
+            pLogger->log("In openMappedVector(...) can't open file", RESULT_CODE::FILE_ERROR);
+        }
+        return nullptr;
+    }
+    struct stat st{};
+    if (fstat(fd, &st) == -1 || st.st_size < static_cast<off_t>(dim * sizeof(double))){
+        close(fd);
+        if (pLogger != nullptr){
+            pLogger->log("In openMappedVector(...) file is shorter than dim coordinates", RESULT_CODE::FILE_ERROR);
+        }
+        return nullptr;
+    }
+    return map(dim, fd, readOnly, pLogger);
+}
+
+double* MappedVector_Impl::data() const {
+    return m_ptr_coord;
+}
+
+size_t MappedVector_Impl::getDim() const {
+    return m_dim;
+}
+
+double MappedVector_Impl::getCoord(size_t index) const {
+    if (index >= m_dim){
+        if (logger != nullptr){
+            logger->log("In getCoord(...)", RESULT_CODE::OUT_OF_BOUNDS);
+        }
+        return NAN;
+    }
+    return m_ptr_coord[index];
+}
+
+RESULT_CODE MappedVector_Impl::setCoord(size_t index, double value) {
+    if (index >= m_dim){
+        if (logger != nullptr){
+            logger->log("In setCoord(...)", RESULT_CODE::OUT_OF_BOUNDS);
+        }
+        return RESULT_CODE::OUT_OF_BOUNDS;
+    }
+    if (m_readOnly){
+        if (logger != nullptr){
+            logger->log("In setCoord(...) vector is mapped read-only", RESULT_CODE::FILE_ERROR);
+        }
+        return RESULT_CODE::FILE_ERROR;
+    }
+    if (__isnan(value)){
+        if (logger != nullptr){
+            logger->log("In setCoord(...)", RESULT_CODE::NAN_VALUE);
+        }
+        return RESULT_CODE::NAN_VALUE;
+    }
+    m_ptr_coord[index] = value;
+    return RESULT_CODE::SUCCESS;
+}
+
+IVector* MappedVector_Impl::clone() const {
+    MappedVector_Impl *pVector = create(m_dim, nullptr, logger);
+    if (pVector == nullptr){
+        return nullptr;
+    }
+    double *pOut = pVector->m_ptr_coord;
+    RESULT_CODE rc = streamChunks(m_dim, threadsFor(m_dim), this, nullptr, logger,
+                                  [&](size_t, const double *a, const double *, size_t begin, size_t len){
+        memcpy(pOut + begin, a, len * sizeof(double));
+    });
+    if (rc != RESULT_CODE::SUCCESS){
+        delete pVector;
+        return nullptr;
+    }
+    return pVector;
+}
+
+double MappedVector_Impl::norm(IVector::NORM norm) const {
+    return streamNorm(this, nullptr, norm, logger);
+}
+
+RESULT_CODE MappedVector_Impl::flush() {
+    if (m_fd == -1 || m_readOnly){
+        return RESULT_CODE::SUCCESS;
+    }
+    if (msync(m_ptr_coord, m_dim * sizeof(double), MS_SYNC) == -1){
+        if (logger != nullptr){
+            logger->log("In flush(...)", RESULT_CODE::FILE_ERROR);
+        }
+        return RESULT_CODE::FILE_ERROR;
+    }
+    return RESULT_CODE::SUCCESS;
+}
+
+IMappedVector* IMappedVector::createMappedVector(char const* pFile, size_t dim, ILogger* pLogger) {
+    if (pFile == nullptr){
+        if (pLogger != nullptr){
+            pLogger->log("In createMappedVector(...) file name is nullptr", RESULT_CODE::BAD_REFERENCE);
+        }
+        return nullptr;
+    }
+    return MappedVector_Impl::create(dim, pFile, pLogger);
+}
+
+IMappedVector* IMappedVector::openMappedVector(char const* pFile, size_t dim, bool readOnly, ILogger* pLogger) {
+    if (pFile == nullptr){
+        if (pLogger != nullptr){
+            pLogger->log("In openMappedVector(...) file name is nullptr", RESULT_CODE::BAD_REFERENCE);
+        }
+        return nullptr;
+    }
+    MappedVector_Impl *pVector = MappedVector_Impl::openFile(dim, pFile, readOnly, pLogger);
+    if (pVector != nullptr && checkNan(pVector, pLogger) != RESULT_CODE::SUCCESS){
+        delete pVector;
+        return nullptr;
+    }
+    return pVector;
+}
+
+IMappedVector* IMappedVector::createMappedVector(size_t dim, ILogger* pLogger) {
+    return MappedVector_Impl::create(dim, nullptr, pLogger);
+}
+
+RESULT_CODE IMappedVector::setThreadCount(size_t count) {
+    if (!count){
+        return RESULT_CODE::WRONG_ARGUMENT;
+    }
+    size_t maxCount = std::max(1u, std::thread::hardware_concurrency());
+    MappedVector_Impl::threadCount = std::min(count, maxCount);
+    return RESULT_CODE::SUCCESS;
+}
+
+IMappedVector* IMappedVector::add(IVector const* pOperand1, IVector const* pOperand2, char const* pFile,
+                                  ILogger* pLogger) {
+    if (!checkOperands(pOperand1, pOperand2, pLogger, "In add(...)")){
+        return nullptr;
+    }
+    return streamMap(pOperand1, pOperand2, pFile, pLogger, "In add(...)",
+                     [](double a, double b){ return a + b; });
+}
+
+IMappedVector* IMappedVector::sub(IVector const* pOperand1, IVector const* pOperand2, char const* pFile,
+                                  ILogger* pLogger) {
+    if (!checkOperands(pOperand1, pOperand2, pLogger, "In sub(...)")){
+        return nullptr;
+    }
+    return streamMap(pOperand1, pOperand2, pFile, pLogger, "In sub(...)",
+                     [](double a, double b){ return a - b; });
+}
+
+IMappedVector* IMappedVector::mul(IVector const* pOperand1, double scaleParam, char const* pFile, ILogger* pLogger) {
+    if (pOperand1 == nullptr){
+        if (pLogger != nullptr){
+            pLogger->log("In mul(...)", RESULT_CODE::BAD_REFERENCE);
+        }
+        return nullptr;
+    }
+    if (__isnan(scaleParam)){
+        if (pLogger != nullptr){
+            pLogger->log("Scale param in mul(...)", RESULT_CODE::NAN_VALUE);
+        }
+        return nullptr;
+    }
+    return streamMap(pOperand1, nullptr, pFile, pLogger, "In mul(...)",
+                     [scaleParam](double a, double){ return a * scaleParam; });
+}
+
+double IMappedVector::mul(IVector const* pOperand1, IVector const* pOperand2, ILogger* pLogger) {
+    if (!checkOperands(pOperand1, pOperand2, pLogger, "In mul(...)")){
+        return NAN;
+    }
+    size_t threads = threadsFor(pOperand1->getDim());
+    std::vector<double> partial(threads, 0);
+    RESULT_CODE rc = streamChunks(pOperand1->getDim(), threads, pOperand1, pOperand2, pLogger,
+                                  [&](size_t t, const double *a, const double *b, size_t, size_t len){
+        double ans = partial[t];
+        for (size_t i = 0; i < len; ++i){
+            ans += a[i] * b[i];
+        }
+        partial[t] = ans;
+    });
+    if (rc != RESULT_CODE::SUCCESS){
+        return NAN;
+    }
+    double ans = 0;
+    for (double val : partial){
+        ans += val;
+    }
+    if (__isnan(ans)){
+        if (pLogger != nullptr){
+            pLogger->log("In mul(...)", RESULT_CODE::CALCULATION_ERROR);
+        }
+        return NAN;
+    }
+    return ans;
+}
+
+RESULT_CODE IMappedVector::equals(IVector const* pOperand1, IVector const* pOperand2, IVector::NORM norm,
+                                  double tolerance, bool* result, ILogger* pLogger) {
+    if (pOperand1 == nullptr || pOperand2 == nullptr || result == nullptr){
+        if (pLogger != nullptr){
+            pLogger->log("In equals(...)", RESULT_CODE::BAD_REFERENCE);
+        }
+        return RESULT_CODE::BAD_REFERENCE;
+    }
+    if (__isnan(tolerance)){
+        if (pLogger != nullptr){
+            pLogger->log("In equals(...) tolerance is NAN", RESULT_CODE::NAN_VALUE);
+        }
+        return RESULT_CODE::NAN_VALUE;
+    }
+    if (pOperand1->getDim() != pOperand2->getDim()){
+        if (pLogger != nullptr){
+            pLogger->log("In equals(...) expected the same dim of operands", RESULT_CODE::WRONG_DIM);
+        }
+        return RESULT_CODE::WRONG_DIM;
+    }
+    // the difference is reduced on the fly instead of being materialized by sub(...)
+    double normValue = streamNorm(pOperand1, pOperand2, norm, pLogger);
+    if (__isnan(normValue)){
+        if (pLogger != nullptr){
+            pLogger->log("In equals(...) norm's value is NAN", RESULT_CODE::NAN_VALUE);
+        }
+        return RESULT_CODE::NAN_VALUE;
+    }
+    *result = normValue <= tolerance;
+    return RESULT_CODE::SUCCESS;
+}
@@ -2,6 +2,7 @@
 // Created by Dmitry Kozlov on 3/6/2020.
 //
 #include "interfaces/IVector.h"
+#include "interfaces/IMappedVector.h"
 #include "interfaces/ILogger.h"
 #include <cmath>
 #include <new>
@@ -11,6 +12,12 @@ IVector::~IVector() = default;
 
 namespace {
 
+    // mapped operands are handled by streaming passes, results go to anonymous mapped pages
+    bool isMapped(IVector const *pOperand1, IVector const *pOperand2 = nullptr){
+        return dynamic_cast<IMappedVector const*>(pOperand1) != nullptr ||
+               dynamic_cast<IMappedVector const*>(pOperand2) != nullptr;
+    }
+
     class Vector_Impl : public IVector {
     public:
         Vector_Impl(size_t dim, double *pCoords, ILogger* pLogger);
@@ -67,6 +74,9 @@ IVector* IVector::add(IVector const *pOperand1, IVector const *pOperand2, ILogge
         }
         return nullptr;
     }
+    if (isMapped(pOperand1, pOperand2)){
+        return IMappedVector::add(pOperand1, pOperand2, nullptr, pLogger);
+    }
     if (pOperand1->getDim() != pOperand2->getDim()){
         if (pLogger != nullptr){
             pLogger->log("In add(...) expected the same dim of operands", RESULT_CODE::WRONG_DIM);
@@ -96,6 +106,9 @@ IVector* IVector::sub(IVector const *pOperand1, IVector const *pOperand2, ILogge
         }
         return nullptr;
     }
+    if (isMapped(pOperand1, pOperand2)){
+        return IMappedVector::sub(pOperand1, pOperand2, nullptr, pLogger);
+    }
     if (pOperand1->getDim() != pOperand2->getDim()){
         if (pLogger != nullptr){
             pLogger->log("In sub(...) expected the same dim of operands", RESULT_CODE::WRONG_DIM);
@@ -125,6 +138,9 @@ double IVector::mul(IVector const *pOperand1, IVector const *pOperand2, ILogger*
         }
         return NAN;
     }
+    if (isMapped(pOperand1, pOperand2)){
+        return IMappedVector::mul(pOperand1, pOperand2, pLogger);
+    }
     if (pOperand1->getDim() != pOperand2->getDim()){
         if (pLogger != nullptr){
             pLogger->log("In mul(...) expected the same dim of operands", RESULT_CODE::WRONG_DIM);
@@ -159,6 +175,9 @@ IVector* IVector::mul(IVector const *pOperand1, double scaleParam, ILogger* pLog
         }
         return nullptr;
     }
+    if (isMapped(pOperand1)){
+        return IMappedVector::mul(pOperand1, scaleParam, nullptr, pLogger);
+    }
     size_t _dim = pOperand1->getDim();
     auto* _arr = new (std::nothrow) double[_dim];
     if (!_arr){
@@ -270,6 +289,9 @@ RESULT_CODE IVector::equals(IVector const *pOperand1, IVector const *pOperand2,
         }
         return RESULT_CODE::NAN_VALUE;
     }
+    if (isMapped(pOperand1, pOperand2)){
+        return IMappedVector::equals(pOperand1, pOperand2, norm, tolerance, result, pLogger);
+    }
     IVector *subVectors = IVector::sub(pOperand1, pOperand2, pLogger);
     if (subVectors == nullptr){
         if (pLogger != nullptr){
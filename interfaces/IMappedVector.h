@@ -0,0 +1,47 @@
+#ifndef IMAPPEDVECTOR_H
+#define IMAPPEDVECTOR_H
+
+#include "IVector.h"
+
+/*
+ * Vector whose coordinates live in a memory mapping instead of a heap block:
+ * either a file on disk or anonymous pages.
+ * All operations stream over the coordinates chunk by chunk, so the dimension
+ * is limited by the address space rather than by a single allocation.
+ */
+class IMappedVector : public IVector {
+public:
+    // maps an existing file holding at least dim coordinates; a read-only vector rejects setCoord(...)
+    static IMappedVector* openMappedVector(char const* pFile, size_t dim, bool readOnly, ILogger* pLogger);
+    // creates or truncates pFile to exactly dim zero coordinates, disk space is reserved up front
+    static IMappedVector* createMappedVector(char const* pFile, size_t dim, ILogger* pLogger);
+    // zero vector backed by anonymous pages
+    static IMappedVector* createMappedVector(size_t dim, ILogger* pLogger);
+
+    // Results are written to pFile, or to anonymous pages if pFile is nullptr.
+    // IVector::add/sub/mul hand mapped operands over to these with pFile == nullptr, so
+    // their result still lives in RAM or swap; pass a file here for results that don't fit.
+    static IMappedVector* add(IVector const* pOperand1, IVector const* pOperand2, char const* pFile, ILogger* pLogger);
+    static IMappedVector* sub(IVector const* pOperand1, IVector const* pOperand2, char const* pFile, ILogger* pLogger);
+    static IMappedVector* mul(IVector const* pOperand1, double scaleParam, char const* pFile, ILogger* pLogger);
+    static double mul(IVector const* pOperand1, IVector const* pOperand2, ILogger* pLogger);
+    static RESULT_CODE equals(IVector const* pOperand1, IVector const* pOperand2, NORM norm, double tolerance,
+                              bool* result, ILogger* pLogger);
+
+    // number of threads used by streaming passes, 1 by default and capped at the hardware threads
+    static RESULT_CODE setThreadCount(size_t count);
+
+    // writes dirty pages back to the file, no-op for anonymous vectors
+    virtual RESULT_CODE flush() = 0;
+
+    ~IMappedVector() override = 0;
+
+protected:
+    IMappedVector() = default;
+
+private:
+    IMappedVector(IMappedVector const& vector) = delete;
+    IMappedVector& operator=(IMappedVector const& vector) = delete;
+};
+
+#endif //IMAPPEDVECTOR_H
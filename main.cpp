@@ -1,6 +1,9 @@
 #include <iostream>
 #include "interfaces/IVector.h"
 #include "interfaces/ISet.h"
+#include "interfaces/IMappedVector.h"
+#include <cstdio>
+#include <vector>
 
 int main() {
     double arr1[2] = {1,2};
@@ -29,6 +32,46 @@ int main() {
     delete set1;
     delete set2;
     delete set3;
+
+    // mapped vectors must agree with the heap implementation, both single- and multithreaded
+    const size_t bigDim = 1u << 18u;
+    std::vector<double> bigArr(bigDim);
+    for (size_t i = 0; i < bigDim; ++i){
+        bigArr[i] = static_cast<double>(i % 7) - 3;
+    }
+    IVector *heapVec = IVector::createVector(bigDim, bigArr.data(), logger);
+    IMappedVector *fileVec = IMappedVector::createMappedVector("mapped_vector.bin", bigDim, logger);
+    IMappedVector *anonVec = IMappedVector::createMappedVector(bigDim, logger);
+    for (size_t i = 0; i < bigDim; ++i){
+        fileVec->setCoord(i, bigArr[i]);
+        anonVec->setCoord(i, bigArr[i]);
+    }
+    fileVec->flush();
+    IMappedVector *inputVec = IMappedVector::openMappedVector("mapped_vector.bin", bigDim, true, logger);
+    std::cout << "read-only setCoord rejected: " << (inputVec->setCoord(0, 1.0) != RESULT_CODE::SUCCESS) << std::endl;
+    for (size_t threads : {1, 4}){
+        IMappedVector::setThreadCount(threads);
+        IVector *sum = IVector::add(inputVec, heapVec, logger);
+        IVector *doubled = IVector::mul(heapVec, 2.0, logger);
+        IVector *copy = anonVec->clone();
+        bool isSumEqual = false, isCopyEqual = false;
+        IVector::equals(sum, doubled, IVector::NORM::NORM_INF, 1e-12, &isSumEqual, logger);
+        IVector::equals(copy, heapVec, IVector::NORM::NORM_1, 1e-12, &isCopyEqual, logger);
+        std::cout << "threads " << threads
+                  << ": add " << isSumEqual
+                  << ", clone " << isCopyEqual
+                  << ", dot " << (IVector::mul(fileVec, anonVec, logger) == IVector::mul(heapVec, heapVec, logger))
+                  << ", norm " << (copy->norm(IVector::NORM::NORM_2) == heapVec->norm(IVector::NORM::NORM_2))
+                  << std::endl;
+        delete sum;
+        delete doubled;
+        delete copy;
+    }
+    delete heapVec;
+    delete fileVec;
+    delete anonVec;
+    delete inputVec;
+    std::remove("mapped_vector.bin");
     logger->destroyLogger(nullptr);
     return 0;
 }
\ No newline at end of file